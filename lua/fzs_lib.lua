@@ -14,10 +14,12 @@ local native = ffi.load(library_path)
 
 ffi.cdef([[
   typedef struct {
-    uint32_t *data;
-    size_t size;
+    unsigned int *data;
+    unsigned int size;
   } fzs_position_t;
 
+  enum { FZS_MAX_POSITIONS = 100 };
+
   fzs_position_t *fzs_get_positions(const char *text, const char *pattern);
   double fzs_get_score(const char *text, const char *pattern);
 ]])
@@ -28,17 +30,35 @@ fzs.get_score = function(input, pattern)
 	return native.fzs_get_score(input, pattern)
 end
 
+-- positions of the current prompt, so redraws and scrolling don't call the lib again
+local pos_cache = { pattern = nil, rows = {} }
+
+local cached_rows = function(pattern)
+	if pos_cache.pattern ~= pattern then
+		pos_cache.pattern = pattern
+		pos_cache.rows = {}
+	end
+	return pos_cache.rows
+end
+
 fzs.get_pos = function(input, pattern)
+	local rows = cached_rows(pattern)
+	if rows[input] ~= nil then
+		return rows[input]
+	end
+
 	local pos = native.fzs_get_positions(input, pattern)
 	if pos == nil then
 		return
 	end
 
+	-- truncated, see fzs_position_t
 	local res = {}
-	for i = 1, tonumber(pos.size) do
+	for i = 1, math.min(tonumber(pos.size), native.FZS_MAX_POSITIONS) do
 		res[i] = pos.data[i - 1] + 1
 	end
 
+	rows[input] = res
 	return res
 end
 
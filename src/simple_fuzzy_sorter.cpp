@@ -5,6 +5,8 @@
 #include <cctype>
 #include <cstring>
 #include <iostream>
+#include <memory>
+#include <memory_resource>
 #include <string_view>
 #include <utility>
 #include <variant>
@@ -18,7 +20,8 @@ namespace
   enum
   {
     U_CHAR_SIZE = 256,
-    BUFFER_SIZE = 100
+    BUFFER_SIZE = FZS_MAX_POSITIONS,
+    ARENA_BLOCK_SIZE = 4096
   };
 
   // small extra bonus for matching sign after oder before the pattern
@@ -78,7 +81,7 @@ namespace
   }
 
   // end is after the last found sign.
-  int scoreBoundary( const string_view &text, u32 begin, u32 end )
+  int scoreBoundary( const string_view &text, size_t begin, size_t end )
   {
     static const vector< unsigned char > boundary = boundaryChars();
     int score = 0;
@@ -90,38 +93,145 @@ namespace
     return score;
   }
 
-  using result_t = variant< int, vector< u32 > >;
+  /*
+   * Scratch memory of one query (scoring one text): a monotonic arena, reset() makes all memory reusable at once.
+   * The memory comes in fixed size blocks which stay pooled in the arena, so after a warm-up the scoring path doesn't
+   * call malloc anymore.
+   */
+  class scratch_arena_c : public pmr::memory_resource
+  {
+  public:
+    void reset()
+    {
+      _block = 0;
+      _used = 0;
+    }
+
+  private:
+    struct block_t
+    {
+      unique_ptr< byte[] > data;
+      size_t size;
+    };
+
+    void *do_allocate( size_t bytes, size_t alignment ) override
+    {
+      for ( ;; )
+      {
+        for ( ; _block < _blocks.size(); ++_block, _used = 0 )
+        {
+          const auto &block = _blocks[ _block ];
+          void *ptr = block.data.get() + _used;
+          size_t space = block.size - _used;
+          if ( std::align( alignment, bytes, ptr, space ) )
+          {
+            _used = block.size - space + bytes;
+            return ptr;
+          }
+        }
+        // larger requests get a larger block, which is pooled as well
+        const size_t size = std::max< size_t >( ARENA_BLOCK_SIZE, bytes + alignment );
+        _blocks.push_back( block_t{ .data = make_unique_for_overwrite< byte[] >( size ), .size = size } );
+        _block = _blocks.size() - 1;
+        _used = 0;
+      }
+    }
+
+    // monotonic: memory is only given back by reset()
+    void do_deallocate( void *, size_t, size_t ) override
+    {
+    }
+
+    bool do_is_equal( const pmr::memory_resource &other ) const noexcept override
+    {
+      return this == &other;
+    }
+
+    vector< block_t > _blocks;
+    size_t _block = 0;
+    size_t _used = 0;
+  };
+
+  struct patternHelper_c
+  {
+    string_view pattern;
+    // only by fuzzy for fast matching (view into cacheUpper)
+    string_view upper;
+
+    // uint utf8size;
+    bool strict;
+  };
+} // namespace
+
+/*
+ * Everything the scorer reuses between calls. It's passed explicitly (no thread_local): the library is built -fPIC,
+ * so every thread_local access would go through __tls_get_addr on the hot path.
+ */
+struct fuzzy_score_n::scorer_state_t
+{
+  // reset by each get_score asking for positions
+  scratch_arena_c scratch;
+  // static vectors are faster (get_fuzzy_score)
+  vector< u32 > positions;
+  vector< u32 > resultPositions;
+  // blocked ranges of multi token patterns
+  vector< pair< u32, u32 > > range;
+  // a small cache for the last pattern - so we don't need to create every check patternHelper
+  pair< string, vector< patternHelper_c > > cachePattern;
+  string cacheUpper; // upper case copy of the pattern, shared by all patternHelpers
+};
+
+namespace
+{
+  // state of the functions without a scorer_context_c (neovim: single threaded)
+  scorer_state_t sharedState;
+
+  // result positions live in the scratch arena of the current query
+  using positions_t = pmr::vector< u32 >;
+  using result_t = variant< int, positions_t >;
+
+  result_t no_positions( scorer_state_t &state )
+  {
+    return result_t{ std::in_place_type< positions_t >, &state.scratch };
+  }
 
   /*
    * calcing a fast strict score (the pattern must match ascending).
    */
-  result_t get_strict_score_1( const string_view &text, const char pattern, const bool getPositions )
+  result_t get_strict_score_1( scorer_state_t &state,
+                               const string_view &text,
+                               const char pattern,
+                               const bool getPositions )
   {
     if ( const auto pos = text.find( pattern ); pos != std::string::npos )
     {
       if ( getPositions )
-        return vector< u32 >{ static_cast< unsigned int >( pos ) };
+        return positions_t( 1, static_cast< unsigned int >( pos ), &state.scratch );
 
       return FULL_MATCH - BOUNDARY_BOTH + scoreBoundary( text, pos, pos + 1 );
     }
 
     if ( getPositions )
-      return vector< u32 >();
+      return no_positions( state );
     return MISMATCH;
   }
 
   /*
    * calcing a fast strict score (the pattern must match ascending).
    */
-  result_t get_strict_score( const string_view &text, const string_view &pattern, const bool getPositions )
+  result_t get_strict_score( scorer_state_t &state,
+                             const string_view &text,
+                             const string_view &pattern,
+                             const bool getPositions )
   {
     if ( const auto pos = text.find( pattern ); pos != std::string::npos )
     {
       const u32 patternSize = static_cast< u32 >( pattern.size() );
       if ( getPositions )
       {
-        vector< u32 > positions;
-        for ( u32 x = pos; x < pos + patternSize; ++x )
+        positions_t positions( &state.scratch );
+        positions.reserve( patternSize );
+        for ( auto x = static_cast< u32 >( pos ); x < pos + patternSize; ++x )
           positions.push_back( x );
         return positions;
       }
@@ -130,7 +240,7 @@ namespace
     }
 
     if ( getPositions )
-      return vector< u32 >();
+      return no_positions( state );
     return MISMATCH;
   }
 
@@ -144,17 +254,18 @@ namespace
    * \getPositions   true: return postions instead of score
    * \blockedRanges  if enabled only allow free spaces
    */
-  result_t get_fuzzy_score( const string_view &text,
+  result_t get_fuzzy_score( scorer_state_t &state,
+                            const string_view &text,
                             const string_view &pattern,
-                            const string &upperPattern,
+                            const string_view &upperPattern,
                             const bool getPositions,
                             vector< pair< u32, u32 > > *blockedRanges = nullptr )
   {
     int score = MISMATCH;
     const size_t maxStartPos = text.size() - pattern.size() + 1;
-    // static vectors are faster
-    static vector< u32 > positions;
-    static vector< u32 > resultPositions;
+    // reused vectors are faster
+    auto &positions = state.positions;
+    auto &resultPositions = state.resultPositions;
     positions.clear();
     resultPositions.clear();
 
@@ -166,7 +277,7 @@ namespace
     {
       penalty = 0;
       startSearchPos = i;
-      u32 maxVarStartPos = maxStartPos - 1;
+      auto maxVarStartPos = static_cast< u32 >( maxStartPos - 1 );
       for ( u32 p = 0; p < pattern.size(); ++p )
       {
         const char patternChar = pattern[ p ];
@@ -246,7 +357,7 @@ namespace
       blockedRanges->push_back( pair( resultPositions.front(), resultPositions.back() ) );
 
     if ( getPositions )
-      return resultPositions;
+      return positions_t( resultPositions.begin(), resultPositions.end(), &state.scratch );
     return score;
   }
 
@@ -269,43 +380,38 @@ namespace
    *   -put togehter multi token results
    * \param getPositions true: get positions instead of a rating
    */
-  result_t get_score( const string_view &text, const char *pattern, const bool getPositions )
+  result_t get_score( scorer_state_t &state, const string_view &text, const char *pattern, const bool getPositions )
   {
+    // positions of the last query are already consumed, the score path doesn't use the arena at all
+    if ( getPositions )
+      state.scratch.reset();
     if ( pattern == nullptr || pattern[ 0 ] == '\0' ) // empty pattern must return match, because of discard
-      return getPositions ? result_t{ vector< u32 >() } : result_t{ FULL_MATCH };
+      return getPositions ? no_positions( state ) : result_t{ FULL_MATCH };
     if ( pattern[ 1 ] == '\0' ) // this will be applied on all file-names, so this must be very fast
     {
       string_view p = pattern;
       if ( std::islower( p.back() ) )
       {
-        const auto res = get_strict_score_1( text,
+        const auto res = get_strict_score_1( state,
+                                             text,
                                              static_cast< char >( std::toupper( static_cast< int >( p.back() ) ) ),
                                              getPositions );
         if ( getPositions || std::get< int >( res ) != MISMATCH )
           return res;
       }
 
-      return get_strict_score_1( text, *pattern, getPositions );
+      return get_strict_score_1( state, text, *pattern, getPositions );
     }
 
     const char sep = ' ';
 
-    struct patternHelper_c
-    {
-      string_view pattern;
-      // only by fuzzy for fast matching
-      string upper;
-
-      // uint utf8size;
-      bool strict;
-    };
-
-    // a small cache for the last pattern - so we don't need to create every check patternHelper
-    static pair< string, vector< patternHelper_c > > cachePattern;
+    auto &cachePattern = state.cachePattern;
+    auto &cacheUpper = state.cacheUpper;
     vector< patternHelper_c > &patternHelpers = cachePattern.second;
     if ( !fast_cmp( cachePattern.first, pattern ) )
     {
       cachePattern.first = pattern;
+      cacheUpper = cachePattern.first;
       const string_view patternString = cachePattern.first;
       patternHelpers.clear();
       bool strict = false;
@@ -333,10 +439,13 @@ namespace
         if ( u32 newPatternSize = y - i; y > 0 )
         {
             // textChar = static_cast< char >( tolower( static_cast< unsigned char >( textChar ) ) );
-          string upper;
+          string_view upper;
           if ( !strict )
+          {
             for ( u32 u = i; u < i + newPatternSize; ++u )
-              upper.push_back( static_cast< char >( toupper( static_cast< int >( patternString[ u ] ) ) ) );
+              cacheUpper[ u ] = static_cast< char >( toupper( static_cast< int >( patternString[ u ] ) ) );
+            upper = string_view( cacheUpper ).substr( i, newPatternSize );
+          }
           patternHelpers.push_back(
             patternHelper_c{ .pattern = patternString.substr( i, newPatternSize ), .upper = upper, .strict = strict } );
           strict = false;
@@ -346,29 +455,33 @@ namespace
     }
 
     if ( cachePattern.first.size() > text.size() )
-      return getPositions ? result_t{ vector< u32 >() } : result_t{ MISMATCH };
+      return getPositions ? no_positions( state ) : result_t{ MISMATCH };
 
     // optimization reason: reduce creation of empty vectors
     if ( patternHelpers.size() == 1 )
     {
       const auto &patternHelper = patternHelpers.back();
-      return patternHelper.strict ? get_strict_score( text, patternHelper.pattern, getPositions )
-                                  : get_fuzzy_score( text, patternHelper.pattern, patternHelper.upper, getPositions );
+      return patternHelper.strict
+               ? get_strict_score( state, text, patternHelper.pattern, getPositions )
+               : get_fuzzy_score( state, text, patternHelper.pattern, patternHelper.upper, getPositions );
     }
 
     // ugly but maybe a little bit faster
-    result_t result = getPositions ? result_t{ std::in_place_type< vector< u32 > > } : result_t{ MISMATCH };
-    vector< pair< u32, u32 > > range;
+    result_t result = getPositions ? no_positions( state ) : result_t{ MISMATCH };
+    auto &range = state.range;
+    range.clear();
     for ( const auto &patternHelper : patternHelpers )
     {
-      auto patternResult = patternHelper.strict ? get_strict_score( text, patternHelper.pattern, getPositions )
-                                                : get_fuzzy_score( text, patternHelper.pattern, patternHelper.upper, getPositions, &range );
+      auto patternResult =
+        patternHelper.strict
+          ? get_strict_score( state, text, patternHelper.pattern, getPositions )
+          : get_fuzzy_score( state, text, patternHelper.pattern, patternHelper.upper, getPositions, &range );
       if ( getPositions )
       {
-        auto &patternPositions = std::get< vector< u32 > >( patternResult );
+        auto &patternPositions = std::get< positions_t >( patternResult );
         if ( patternPositions.empty() )
-          return patternPositions;
-        auto &positions = std::get< vector< u32 > >( result );
+          return patternResult;
+        auto &positions = std::get< positions_t >( result );
         if ( positions.empty() )
           std::swap( positions, patternPositions );
         else
@@ -390,10 +503,34 @@ namespace
 
 namespace fuzzy_score_n
 {
+  scorer_context_c::scorer_context_c() :
+    _state( make_unique< scorer_state_t >() )
+  {
+  }
+
+  scorer_context_c::~scorer_context_c() = default;
+
   // ma score is the best :)
   int fzs_get_score( const char *text, const char *pattern )
   {
-    return std::get< int >( get_score( text, pattern, false ) );
+    return std::get< int >( get_score( sharedState, text, pattern, false ) );
+  }
+
+  int fzs_get_score( const char *text, const char *pattern, scorer_context_c &context )
+  {
+    return std::get< int >( get_score( *context._state, text, pattern, false ) );
+  }
+
+  std::vector< u32 > fzs_get_match_positions( const char *text, const char *pattern )
+  {
+    const auto positions = std::get< positions_t >( get_score( sharedState, text, pattern, true ) );
+    return vector< u32 >( positions.begin(), positions.end() );
+  }
+
+  std::vector< u32 > fzs_get_match_positions( const char *text, const char *pattern, scorer_context_c &context )
+  {
+    const auto positions = std::get< positions_t >( get_score( *context._state, text, pattern, true ) );
+    return vector< u32 >( positions.begin(), positions.end() );
   }
 } // namespace fuzzy_score_n
 
@@ -414,7 +551,7 @@ fzs_position_t *fzs_get_positions( const char *text, const char *pattern )
   // save mem - nice trick :-)
   static array< u32, BUFFER_SIZE > array;
   static fzs_position_t result{ .data = array.data(), .size = 0 };
-  const auto positions = std::get< vector< u32 > >( get_score( text, pattern, true ) );
+  const auto positions = std::get< positions_t >( get_score( sharedState, text, pattern, true ) );
 
   const auto size = std::min( positions.size(), array.size() );
   for ( u32 i = 0; i < size; ++i )
@@ -424,3 +561,26 @@ fzs_position_t *fzs_get_positions( const char *text, const char *pattern )
 
   return &result;
 }
+
+// the pattern is compiled once (pattern cache of get_score) for all rows
+unsigned int fzs_get_positions_batch( const char *const *corpus,
+                                      const char *pattern,
+                                      const unsigned int *ids,
+                                      unsigned int n,
+                                      unsigned int *out_offsets,
+                                      unsigned int *out_positions )
+{
+  u32 offset = 0;
+  for ( u32 i = 0; i < n; ++i )
+  {
+    out_offsets[ i ] = offset;
+    const char *text = corpus[ ids ? ids[ i ] : i ];
+    const auto positions = std::get< positions_t >( get_score( sharedState, text, pattern, true ) );
+    const auto size = static_cast< u32 >( std::min< size_t >( positions.size(), BUFFER_SIZE ) );
+    std::copy_n( positions.begin(), size, out_positions + offset );
+    offset += size;
+  }
+  out_offsets[ n ] = offset;
+
+  return offset;
+}
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
+#include <vector>
 using u32 = std::uint32_t;
 
 namespace fuzzy_score_n
@@ -17,17 +19,64 @@ namespace fuzzy_score_n
     MATCH_CHAR = 10,
   };
 
+  struct scorer_state_t;
+
+  /*
+   * Pattern cache and scratch memory of the scorer. The functions without a context share one static state, so they
+   * must only be used by one thread (neovim). Every other thread needs its own context.
+   */
+  class scorer_context_c
+  {
+  public:
+    scorer_context_c();
+    ~scorer_context_c();
+    scorer_context_c( const scorer_context_c & ) = delete;
+    scorer_context_c &operator=( const scorer_context_c & ) = delete;
+
+  private:
+    friend int fzs_get_score( const char *text, const char *pattern, scorer_context_c &context );
+    friend std::vector< u32 > fzs_get_match_positions( const char *text,
+                                                       const char *pattern,
+                                                       scorer_context_c &context );
+
+    std::unique_ptr< scorer_state_t > _state;
+  };
+
   int fzs_get_score( const char *text, const char *pattern );
+  int fzs_get_score( const char *text, const char *pattern, scorer_context_c &context );
+  // all matched byte positions (not truncated like the C-Interface)
+  std::vector< u32 > fzs_get_match_positions( const char *text, const char *pattern );
+  std::vector< u32 > fzs_get_match_positions( const char *text, const char *pattern, scorer_context_c &context );
 } // namespace fuzzy_score_n
 
 extern "C"
 {
+  /*
+   * size is the number of all matched positions, but data only holds the first FZS_MAX_POSITIONS of them:
+   * read min( size, FZS_MAX_POSITIONS ) entries.
+   */
   typedef struct
   {
     unsigned int *data;
     unsigned int size;
   } fzs_position_t;
 
+  enum
+  {
+    FZS_MAX_POSITIONS = 100 // positions per text returned by the C-Interface
+  };
+
   double fzs_get_score( const char *text, const char *pattern );
   fzs_position_t *fzs_get_positions( const char *text, const char *pattern );
+  /*
+   * positions of several rows (e.g. the visible ones) within one call. Row i is corpus[ ids[ i ] ] (ids may be NULL:
+   * row i is corpus[ i ]), its positions are out_positions[ out_offsets[ i ] .. out_offsets[ i + 1 ] - 1 ].
+   * out_offsets needs n + 1 entries, out_positions n * FZS_MAX_POSITIONS. Returns the number of written positions.
+   */
+  unsigned int fzs_get_positions_batch( const char *const *corpus,
+                                        const char *pattern,
+                                        const unsigned int *ids,
+                                        unsigned int n,
+                                        unsigned int *out_offsets,
+                                        unsigned int *out_positions );
 }
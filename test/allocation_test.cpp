@@ -0,0 +1,123 @@
+#include <array>
+#include <cstdlib>
+#include <gtest/gtest.h>
+#include <new>
+#include <vector>
+
+#include "simple_fuzzy_sorter.h"
+
+/*
+ * Counts the calls of the global operator new (the library uses it through the std containers) to check that the
+ * scoring path doesn't allocate anymore after a warm-up.
+ */
+namespace
+{
+  bool countAllocations = false;
+  size_t allocations = 0;
+
+  void *allocate( std::size_t size )
+  {
+    if ( countAllocations )
+      ++allocations;
+    if ( void *ptr = std::malloc( size ? size : 1 ) )
+      return ptr;
+    throw std::bad_alloc();
+  }
+} // namespace
+
+void *operator new( std::size_t size )
+{
+  return allocate( size );
+}
+
+void *operator new[]( std::size_t size )
+{
+  return allocate( size );
+}
+
+void *operator new( std::size_t size, const std::nothrow_t & ) noexcept
+{
+  if ( countAllocations )
+    ++allocations;
+  return std::malloc( size ? size : 1 );
+}
+
+void operator delete( void *ptr ) noexcept
+{
+  std::free( ptr );
+}
+
+void operator delete[]( void *ptr ) noexcept
+{
+  std::free( ptr );
+}
+
+void operator delete( void *ptr, std::size_t ) noexcept
+{
+  std::free( ptr );
+}
+
+void operator delete[]( void *ptr, std::size_t ) noexcept
+{
+  std::free( ptr );
+}
+
+namespace
+{
+  enum
+  {
+    MAX_TEXTS = 16
+  };
+
+  const std::vector< const char * > texts = { "init.lua",
+                                              "/home/shazor/.config/nvim/init.lua",
+                                              "mapping_suggest_station_header.cpp",
+                                              "integration_location_util.cpp",
+                                              "INTEGRATION.cmake",
+                                              "übertriebenerText.xml",
+                                              "network/mail_queue.cpp",
+                                              "tmpl/unique_type_range.h",
+                                              "src/engine/math_engine.cpp",
+                                              "README.md" };
+
+  // single char, fuzzy, multi token (blocked ranges), strict upper case and utf-8 prompts
+  const std::vector< const char * > patterns = {
+    "m", "init", "mpns", "location util", "in lo ut", "INT cmake", "über text", "que ue", "map sug ope", "read" };
+
+  // one keystroke: score every text, then the positions of the matches (telescope highlighter)
+  void query( const char *pattern )
+  {
+    std::array< const char *, MAX_TEXTS > matches;
+    unsigned int matchCount = 0;
+    for ( const char *text : texts )
+      if ( fzs_get_score( text, pattern ) > 0.0 )
+        matches[ matchCount++ ] = text;
+
+    for ( unsigned int i = 0; i < matchCount; ++i )
+      fzs_get_positions( matches[ i ], pattern );
+
+    std::array< unsigned int, MAX_TEXTS + 1 > offsets;
+    std::array< unsigned int, size_t{ MAX_TEXTS } * FZS_MAX_POSITIONS > positions;
+    fzs_get_positions_batch( matches.data(), pattern, nullptr, matchCount, offsets.data(), positions.data() );
+
+    // a scoring thread of fzs-filter
+    static fuzzy_score_n::scorer_context_c context;
+    for ( const char *text : texts )
+      fuzzy_score_n::fzs_get_score( text, pattern, context );
+  }
+} // namespace
+
+TEST( AllocationTest, steady_state_queries_dont_allocate )
+{
+  for ( const char *pattern : patterns ) // warm-up
+    query( pattern );
+
+  for ( const char *pattern : patterns )
+  {
+    allocations = 0;
+    countAllocations = true;
+    query( pattern );
+    countAllocations = false;
+    EXPECT_EQ( allocations, 0 ) << "pattern: '" << pattern << "'";
+  }
+}
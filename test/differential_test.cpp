@@ -0,0 +1,213 @@
+#include <chrono>
+#include <gtest/gtest.h>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "reference_scorer.h"
+#include "scorer_engines.h"
+
+using namespace std;
+using namespace scorer_engines_n;
+
+/*
+ * Property based differential test: random paths and prompts, every engine must return exactly the score and the
+ * positions of the reference scorer. The seed is fixed, so a failure is reproducible.
+ */
+namespace
+{
+  enum
+  {
+    SEED = 4711,
+    TEXTS = 2000,
+    PROMPTS_PER_TEXT = 20,
+    MAX_FAILURES = 20
+  };
+
+  const vector< string > words = { "init", "lua", "wrapper", "unsafe", "location", "util", "queue", "mail",
+                                   "config", "parser", "thread", "pool", "render", "mapping", "suggest", "station",
+                                   "header", "integration", "network", "unique", "type", "range", "aaa", "abab" };
+  const vector< string > separators = { "/", "_", "-", ".", " ", "(", ")", ":", "" };
+  // utf-8 with and without upper case counterparts
+  const vector< string > utf8Chars = { "ü", "Ü", "ä", "ß", "é", "€", "日本" };
+
+  class generator_c
+  {
+  public:
+    explicit generator_c( unsigned int seed ) :
+      _random( seed )
+    {
+    }
+
+    size_t pick( size_t size )
+    {
+      return uniform_int_distribution< size_t >( 0, size - 1 )( _random );
+    }
+
+    bool chance( double probability )
+    {
+      return bernoulli_distribution( probability )( _random );
+    }
+
+    char letter()
+    {
+      return static_cast< char >( 'a' + pick( 26 ) );
+    }
+
+    string word()
+    {
+      string word = chance( 0.7 ) ? words[ pick( words.size() ) ] : string();
+      for ( size_t i = pick( 6 ); i > 0; --i )
+        word.push_back( letter() );
+      if ( chance( 0.1 ) ) // repeated letters
+        word.append( 2 + pick( 6 ), letter() );
+      if ( chance( 0.1 ) )
+        word.insert( pick( word.size() + 1 ), utf8Chars[ pick( utf8Chars.size() ) ] );
+      if ( chance( 0.15 ) )
+        for ( auto &c : word )
+          if ( c > 0 && chance( 0.5 ) )
+            c = static_cast< char >( toupper( c ) );
+      return word;
+    }
+
+    string path()
+    {
+      string path;
+      for ( size_t i = 1 + pick( 8 ); i > 0; --i )
+      {
+        path += word();
+        path += separators[ pick( separators.size() ) ];
+      }
+      if ( chance( 0.05 ) ) // long gap
+        path.append( 20 + pick( 200 ), 'x' );
+      return path;
+    }
+
+    // prompts mostly built from the text, so a good part of them matches
+    string prompt( const string &text )
+    {
+      string prompt;
+      for ( size_t tokens = 1 + pick( chance( 0.3 ) ? 4 : 1 ); tokens > 0; --tokens )
+      {
+        if ( !prompt.empty() )
+          prompt.push_back( ' ' );
+        if ( text.empty() || chance( 0.15 ) )
+        {
+          prompt += word();
+          continue;
+        }
+        // a subsequence of the text with small and large gaps
+        size_t pos = pick( text.size() );
+        for ( size_t length = 1 + pick( 6 ); length > 0 && pos < text.size(); --length )
+        {
+          const char c = text[ pos ];
+          if ( c != ' ' )
+            prompt.push_back( chance( 0.1 ) ? static_cast< char >( tolower( static_cast< unsigned char >( c ) ) )
+                                            : c );
+          pos += 1 + ( chance( 0.3 ) ? pick( 4 ) : 0 );
+        }
+      }
+      if ( chance( 0.05 ) && prompt[ 0 ] > 0 ) // single (ascii) char prompt
+        prompt = prompt.substr( 0, 1 );
+      return prompt;
+    }
+
+  private:
+    mt19937 _random;
+  };
+
+  struct sample_t
+  {
+    string text;
+    string prompt;
+  };
+
+  // more matched bytes than the C-Interface returns (FZS_MAX_POSITIONS): fuzzy, strict and multi token
+  const vector< sample_t > longMatches = {
+    { .text = string( 150, 'a' ), .prompt = string( 120, 'a' ) },
+    { .text = "src/" + string( 150, 'A' ) + ".cpp", .prompt = string( 120, 'A' ) },
+    { .text = string( 70, 'a' ) + "_" + string( 70, 'b' ), .prompt = string( 60, 'a' ) + " " + string( 60, 'b' ) },
+    { .text = string( 101, 'x' ), .prompt = string( 101, 'x' ) },
+  };
+
+  vector< sample_t > samples()
+  {
+    generator_c generator( SEED );
+    vector< sample_t > samples = longMatches;
+    for ( u32 t = 0; t < TEXTS; ++t )
+    {
+      const string text = generator.path();
+      for ( u32 p = 0; p < PROMPTS_PER_TEXT; ++p )
+        samples.push_back( sample_t{ .text = text, .prompt = generator.prompt( text ) } );
+    }
+    return samples;
+  }
+} // namespace
+
+TEST( DifferentialTest, engines_match_reference )
+{
+  const auto testSamples = samples();
+  u32 matches = 0;
+  for ( const auto &engine : engines )
+  {
+    u32 failures = 0;
+    for ( const auto &sample : testSamples )
+    {
+      const char *text = sample.text.c_str();
+      const char *prompt = sample.prompt.c_str();
+      const int expectedScore = reference_n::get_score( text, prompt );
+      const int score = engine.score( text, prompt );
+      if ( score != expectedScore )
+      {
+        ADD_FAILURE() << engine.name << " score " << score << " != " << expectedScore << " text: '" << text
+                      << "' prompt: '" << prompt << "'";
+        ++failures;
+      }
+      else if ( expectedScore != fuzzy_score_n::MISMATCH ) // positions are only asked for matches (discard mode)
+      {
+        ++matches;
+        if ( engine.positions( text, prompt ) != expected_positions( engine, text, prompt ) )
+        {
+          ADD_FAILURE() << engine.name << " positions differ, text: '" << text << "' prompt: '" << prompt << "'";
+          ++failures;
+        }
+      }
+      if ( failures >= MAX_FAILURES )
+        break;
+    }
+  }
+  cout << "samples: " << testSamples.size() << " matches: " << matches / engines.size() << endl;
+}
+
+// the long samples must really exceed the buffer of the C-Interface, otherwise the truncation isn't tested
+TEST( DifferentialTest, long_matches_exceed_c_interface )
+{
+  for ( const auto &sample : longMatches )
+    EXPECT_GT( reference_n::get_positions( sample.text.c_str(), sample.prompt.c_str() ).size(), FZS_MAX_POSITIONS )
+      << "prompt: '" << sample.prompt << "'";
+}
+
+TEST( DifferentialTest, engines_throughput )
+{
+  using namespace std::chrono;
+  const auto testSamples = samples();
+  size_t bytes = 0;
+  for ( const auto &sample : testSamples )
+    bytes += sample.text.size();
+
+  const auto measure = [ & ]( const char *name, auto score )
+  {
+    int checksum = 0;
+    const auto start = steady_clock::now();
+    for ( const auto &sample : testSamples )
+      checksum += score( sample.text.c_str(), sample.prompt.c_str() );
+    const double seconds = duration< double >( steady_clock::now() - start ).count();
+    cout << name << ": " << testSamples.size() / seconds / 1e6 << " M scores/s, " << bytes / seconds / 1e6
+         << " MB/s (checksum " << checksum << ")" << endl;
+  };
+
+  measure( "reference", reference_n::get_score );
+  for ( const auto &engine : engines )
+    measure( engine.name, engine.score );
+}
@@ -0,0 +1,50 @@
+/*
+ * libFuzzer differential target: input is "<text>\n<prompt>", every engine must match the reference scorer.
+ * Build with clang: cmake -DFZS_FUZZ=ON -DCMAKE_CXX_COMPILER=clang++ ... && ./fzs_fuzz -max_total_time=60
+ */
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "reference_scorer.h"
+#include "scorer_engines.h"
+
+using namespace std;
+using namespace scorer_engines_n;
+
+namespace
+{
+  [[noreturn]] void report( const char *what, const char *engine, const string &text, const string &prompt )
+  {
+    fprintf( stderr, "%s: %s differs from the reference, text: '%s' prompt: '%s'\n", what, engine, text.c_str(),
+             prompt.c_str() );
+    abort();
+  }
+} // namespace
+
+extern "C" int LLVMFuzzerTestOneInput( const uint8_t *data, size_t size )
+{
+  const string input( reinterpret_cast< const char * >( data ), size );
+  if ( input.find( '\0' ) != string::npos ) // the interfaces take c-strings
+    return -1;
+  const auto newline = input.find( '\n' );
+  if ( newline == string::npos )
+    return -1;
+  const string text = input.substr( 0, newline );
+  const string prompt = input.substr( newline + 1 );
+
+  const int expectedScore = reference_n::get_score( text.c_str(), prompt.c_str() );
+  for ( const auto &engine : engines )
+  {
+    if ( engine.score( text.c_str(), prompt.c_str() ) != expectedScore )
+      report( "score", engine.name, text, prompt );
+    if ( expectedScore != fuzzy_score_n::MISMATCH &&
+         engine.positions( text.c_str(), prompt.c_str() ) !=
+           expected_positions( engine, text.c_str(), prompt.c_str() ) )
+      report( "positions", engine.name, text, prompt );
+  }
+
+  return 0;
+}
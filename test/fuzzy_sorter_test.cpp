@@ -178,6 +178,24 @@ TEST( FuzzySorter, fuzzy_file_upper_case_pos )
   EXPECT_EQ( posis->data[ 6 ], 15 );
 }
 
+TEST( FuzzySorter, fuzzy_file_pos_batch )
+{
+  const char *corpus[] = { "init.lua", "mapping.cpp", "INTEGRATION.cmake", "src/init.lua" };
+  const unsigned int ids[] = { 3, 0, 2 };
+  unsigned int offsets[ 4 ];
+  unsigned int positions[ 3 * FZS_MAX_POSITIONS ];
+  const auto size = fzs_get_positions_batch( corpus, "init", ids, 3, offsets, positions );
+  EXPECT_EQ( size, 8 );
+  EXPECT_EQ( offsets[ 0 ], 0 );
+  EXPECT_EQ( offsets[ 1 ], 4 );
+  EXPECT_EQ( offsets[ 2 ], 8 );
+  EXPECT_EQ( offsets[ 3 ], 8 ); // mismatch
+  EXPECT_EQ( positions[ 0 ], 4 );
+  EXPECT_EQ( positions[ 3 ], 7 );
+  EXPECT_EQ( positions[ 4 ], 0 );
+  EXPECT_EQ( positions[ 7 ], 3 );
+}
+
 TEST( FuzzySorter, fuzzy_file_upper_case_only )
 {
   auto score = fuzzy_score_n::fzs_get_score( "README.md", "read" );
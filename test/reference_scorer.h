@@ -0,0 +1,12 @@
+#pragma once
+
+#include "simple_fuzzy_sorter.h"
+
+#include <vector>
+
+// frozen scalar scorer - the oracle every optimized engine is checked against
+namespace reference_n
+{
+  int get_score( const char *text, const char *pattern );
+  std::vector< u32 > get_positions( const char *text, const char *pattern );
+} // namespace reference_n
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "reference_scorer.h"
+#include "simple_fuzzy_sorter.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+/*
+ * Every scoring engine of the library, checked against reference_n by the differential test and the fuzz target.
+ * A new engine (or isa variant) must be added here.
+ */
+namespace scorer_engines_n
+{
+  enum : size_t
+  {
+    ALL_POSITIONS = std::numeric_limits< size_t >::max()
+  };
+
+  struct engine_t
+  {
+    const char *name;
+    int ( *score )( const char *text, const char *pattern );
+    std::vector< u32 > ( *positions )( const char *text, const char *pattern );
+    size_t maxPositions; // the C-Interface only returns the first FZS_MAX_POSITIONS
+  };
+
+  // the C-Interface used by lua: 1 / score (-1 for mismatch) and positions truncated to its buffer
+  inline int c_interface_score( const char *text, const char *pattern )
+  {
+    const double score = ::fzs_get_score( text, pattern );
+    if ( score < 0.0 )
+      return fuzzy_score_n::MISMATCH;
+    return static_cast< int >( 1.0 / score + 0.5 );
+  }
+
+  inline std::vector< u32 > c_interface_positions( const char *text, const char *pattern )
+  {
+    const fzs_position_t *positions = ::fzs_get_positions( text, pattern );
+    // see fzs_position_t
+    const size_t size = std::min< size_t >( positions->size, FZS_MAX_POSITIONS );
+    return std::vector< u32 >( positions->data, positions->data + size );
+  }
+
+  // one row through the batch interface (highlighting in telescope)
+  inline std::vector< u32 > batch_positions( const char *text, const char *pattern )
+  {
+    std::array< unsigned int, 2 > offsets{};
+    std::array< unsigned int, FZS_MAX_POSITIONS > positions{};
+    ::fzs_get_positions_batch( &text, pattern, nullptr, 1, offsets.data(), positions.data() );
+    return std::vector< u32 >( positions.begin() + offsets[ 0 ], positions.begin() + offsets[ 1 ] );
+  }
+
+  // the explicit scorer context (fzs-filter threads)
+  inline fuzzy_score_n::scorer_context_c &test_context()
+  {
+    static fuzzy_score_n::scorer_context_c context;
+    return context;
+  }
+
+  inline int context_score( const char *text, const char *pattern )
+  {
+    return fuzzy_score_n::fzs_get_score( text, pattern, test_context() );
+  }
+
+  inline std::vector< u32 > context_positions( const char *text, const char *pattern )
+  {
+    return fuzzy_score_n::fzs_get_match_positions( text, pattern, test_context() );
+  }
+
+  inline const std::array engines{
+    engine_t{ "scalar", fuzzy_score_n::fzs_get_score, fuzzy_score_n::fzs_get_match_positions, ALL_POSITIONS },
+    engine_t{ "scalar-context", context_score, context_positions, ALL_POSITIONS },
+    engine_t{ "c-interface", c_interface_score, c_interface_positions, FZS_MAX_POSITIONS },
+    engine_t{ "c-interface-batch", c_interface_score, batch_positions, FZS_MAX_POSITIONS },
+  };
+
+  // the reference positions, truncated like the engine does
+  inline std::vector< u32 > expected_positions( const engine_t &engine, const char *text, const char *pattern )
+  {
+    auto positions = reference_n::get_positions( text, pattern );
+    if ( positions.size() > engine.maxPositions )
+      positions.resize( engine.maxPositions );
+    return positions;
+  }
+} // namespace scorer_engines_n
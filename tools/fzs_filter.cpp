@@ -0,0 +1,399 @@
+/*
+ * fzs-filter: headless front end for libfuzzy_sorter (like 'fzf --filter').
+ * Reads candidates line by line from stdin or a file, scores them against a pattern and writes the ranked top-K.
+ * Useful for shell pipelines and for profiling the engine with perf without driving neovim.
+ */
+#include "simple_fuzzy_sorter.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace fuzzy_score_n;
+
+namespace
+{
+  enum
+  {
+    CHUNK_SIZE = 1 << 20,
+    OUT_BUFFER_SIZE = 1 << 16
+  };
+
+  using steady_t = chrono::steady_clock;
+
+  struct options_t
+  {
+    const char *pattern = nullptr;
+    const char *file = nullptr;
+    size_t topK = 0; // 0: all matches
+    u32 threads = 0; // 0: hardware concurrency
+    u32 rounds = 1;
+    bool positions = false;
+    bool scores = false;
+    bool bench = false;
+  };
+
+  struct candidate_t
+  {
+    const char *text; // null terminated inside a chunk
+    u32 size;
+  };
+
+  struct hit_t
+  {
+    int score;
+    u32 index;
+  };
+
+  // higher score first, equal scores keep the input order
+  bool better( const hit_t &lhs, const hit_t &rhs )
+  {
+    return lhs.score != rhs.score ? lhs.score > rhs.score : lhs.index < rhs.index;
+  }
+
+  void usage( FILE *out )
+  {
+    fputs( "usage: fzs-filter [options] [--] PATTERN [FILE]\n"
+           "  reads candidates from FILE (stdin without FILE or for '-') and prints the matches, best first\n"
+           "  '--' ends the options, e.g. for a pattern starting with '-'\n"
+           "options:\n"
+           "  -k, --top N       print only the best N matches (default: all)\n"
+           "  -j, --threads N   number of scoring threads (default: hardware concurrency)\n"
+           "  -p, --positions   append the matched byte positions: <line>\\t<pos,pos,...>\n"
+           "  -s, --scores      prefix each line with its score: <score>\\t<line>\n"
+           "  -b, --bench       print per-stage timings to stderr\n"
+           "  -r, --rounds N    repeat the scoring stage N times (for benchmarking)\n"
+           "  -h, --help        show this help\n",
+           out );
+  }
+
+  bool parse_number( const char *arg, size_t &value )
+  {
+    if ( arg == nullptr )
+      return false;
+    const char *end = arg + strlen( arg );
+    const auto [ ptr, ec ] = from_chars( arg, end, value );
+    return ec == errc() && ptr == end;
+  }
+
+  bool parse_options( int argc, char **argv, options_t &options )
+  {
+    bool endOfOptions = false;
+    for ( int i = 1; i < argc; ++i )
+    {
+      const string_view arg = argv[ i ];
+      if ( endOfOptions || arg == "-" || !arg.starts_with( '-' ) )
+      {
+        if ( options.pattern == nullptr )
+          options.pattern = argv[ i ];
+        else if ( options.file == nullptr )
+          options.file = argv[ i ];
+        else
+          return false;
+        continue;
+      }
+
+      const char *value = i + 1 < argc ? argv[ i + 1 ] : nullptr;
+      size_t number = 0;
+      if ( arg == "--" )
+        endOfOptions = true;
+      else if ( arg == "-h" || arg == "--help" )
+      {
+        usage( stdout );
+        exit( 0 );
+      }
+      else if ( arg == "-p" || arg == "--positions" )
+        options.positions = true;
+      else if ( arg == "-s" || arg == "--scores" )
+        options.scores = true;
+      else if ( arg == "-b" || arg == "--bench" )
+        options.bench = true;
+      else if ( arg == "-k" || arg == "--top" )
+      {
+        if ( !parse_number( value, number ) )
+          return false;
+        options.topK = number;
+        ++i;
+      }
+      else if ( arg == "-j" || arg == "--threads" )
+      {
+        if ( !parse_number( value, number ) || number == 0 )
+          return false;
+        options.threads = static_cast< u32 >( number );
+        ++i;
+      }
+      else if ( arg == "-r" || arg == "--rounds" )
+      {
+        if ( !parse_number( value, number ) || number == 0 )
+          return false;
+        options.rounds = static_cast< u32 >( number );
+        ++i;
+      }
+      else
+        return false;
+    }
+
+    return options.pattern != nullptr;
+  }
+
+  /*
+   * Reads the whole input in large chunks. Lines are terminated in place ('\n' -> '\0'), so the candidates point
+   * directly into the chunks - there is no allocation per line. A line crossing a chunk border is moved to the
+   * front of the next chunk.
+   */
+  class line_reader_c
+  {
+  public:
+    bool read( FILE *input, vector< candidate_t > &candidates )
+    {
+      size_t chunkSize = CHUNK_SIZE;
+      size_t carry = 0;
+      for ( ;; )
+      {
+        // a single line may be larger than a chunk
+        if ( carry * 2 > chunkSize )
+          chunkSize = carry * 2;
+        auto chunk = make_unique< char[] >( chunkSize + 1 );
+        if ( carry > 0 )
+          memcpy( chunk.get(), _tail, carry );
+
+        const size_t readSize = fread( chunk.get() + carry, 1, chunkSize - carry, input );
+        if ( ferror( input ) )
+          return false;
+        const size_t size = carry + readSize;
+        const bool eof = readSize < chunkSize - carry;
+
+        char *begin = chunk.get();
+        char *const end = begin + size;
+        while ( char *newline = static_cast< char * >( memchr( begin, '\n', static_cast< size_t >( end - begin ) ) ) )
+        {
+          add( candidates, begin, newline );
+          begin = newline + 1;
+        }
+
+        carry = static_cast< size_t >( end - begin );
+        if ( eof )
+        {
+          if ( carry > 0 ) // last line without '\n'
+            add( candidates, begin, end );
+          _chunks.push_back( std::move( chunk ) );
+          return true;
+        }
+        _tail = begin; // stays valid: the chunk is kept until the next one is filled
+        _chunks.push_back( std::move( chunk ) );
+      }
+    }
+
+  private:
+    static void add( vector< candidate_t > &candidates, char *begin, char *end )
+    {
+      if ( end > begin && end[ -1 ] == '\r' )
+        --end;
+      *end = '\0';
+      candidates.push_back( candidate_t{ .text = begin, .size = static_cast< u32 >( end - begin ) } );
+    }
+
+    vector< unique_ptr< char[] > > _chunks;
+    const char *_tail = nullptr;
+  };
+
+  // every thread scores a contiguous slice with its own scorer context and keeps only its own best topK
+  void score_slice( fuzzy_score_n::scorer_context_c &context,
+                    const vector< candidate_t > &candidates,
+                    const char *pattern,
+                    size_t topK,
+                    u32 begin,
+                    u32 end,
+                    vector< hit_t > &hits )
+  {
+    hits.clear();
+    for ( u32 i = begin; i < end; ++i )
+      if ( const int score = fuzzy_score_n::fzs_get_score( candidates[ i ].text, pattern, context ); score != MISMATCH )
+        hits.push_back( hit_t{ .score = score, .index = i } );
+
+    if ( topK > 0 && hits.size() > topK )
+    {
+      partial_sort( hits.begin(), hits.begin() + static_cast< ptrdiff_t >( topK ), hits.end(), better );
+      hits.resize( topK );
+    }
+  }
+
+  class output_c
+  {
+  public:
+    ~output_c()
+    {
+      flush();
+    }
+
+    void write( string_view text )
+    {
+      if ( _buffer.size() + text.size() > OUT_BUFFER_SIZE )
+        flush();
+      _buffer.append( text );
+    }
+
+    template< class NUMBER >
+    void write_number( NUMBER value )
+    {
+      array< char, 16 > digits;
+      const auto [ ptr, ec ] = to_chars( digits.data(), digits.data() + digits.size(), value );
+      write( string_view( digits.data(), static_cast< size_t >( ptr - digits.data() ) ) );
+    }
+
+    void flush()
+    {
+      fwrite( _buffer.data(), 1, _buffer.size(), stdout );
+      _buffer.clear();
+    }
+
+  private:
+    string _buffer;
+  };
+
+  double ms( steady_t::time_point begin, steady_t::time_point end )
+  {
+    return chrono::duration< double, milli >( end - begin ).count();
+  }
+} // namespace
+
+int main( int argc, char **argv )
+{
+  options_t options;
+  if ( !parse_options( argc, argv, options ) )
+  {
+    usage( stderr );
+    return 2;
+  }
+
+  const auto startRead = steady_t::now();
+  const bool readStdin = options.file == nullptr || string_view( options.file ) == "-";
+  FILE *input = readStdin ? stdin : fopen( options.file, "rb" );
+  if ( input == nullptr )
+  {
+    fprintf( stderr, "fzs-filter: can't open '%s'\n", options.file );
+    return 2;
+  }
+  line_reader_c reader;
+  vector< candidate_t > candidates;
+  const bool readOk = reader.read( input, candidates );
+  if ( input != stdin )
+    fclose( input );
+  if ( !readOk )
+  {
+    fprintf( stderr, "fzs-filter: read error\n" );
+    return 2;
+  }
+
+  const auto startScore = steady_t::now();
+  const u32 candidateCount = static_cast< u32 >( candidates.size() );
+  u32 threadCount = options.threads ? options.threads : max( 1u, thread::hardware_concurrency() );
+  threadCount = max( 1u, min( threadCount, candidateCount ) );
+  vector< vector< hit_t > > threadHits( threadCount );
+  vector< fuzzy_score_n::scorer_context_c > contexts( threadCount );
+  for ( u32 round = 0; round < options.rounds; ++round )
+  {
+    vector< thread > workers;
+    const u32 sliceSize = ( candidateCount + threadCount - 1 ) / threadCount;
+    for ( u32 t = 1; t < threadCount; ++t )
+      workers.emplace_back( score_slice,
+                            ref( contexts[ t ] ),
+                            cref( candidates ),
+                            options.pattern,
+                            options.topK,
+                            min( t * sliceSize, candidateCount ),
+                            min( ( t + 1 ) * sliceSize, candidateCount ),
+                            ref( threadHits[ t ] ) );
+    score_slice( contexts[ 0 ],
+                 candidates,
+                 options.pattern,
+                 options.topK,
+                 0,
+                 min( sliceSize, candidateCount ),
+                 threadHits[ 0 ] );
+    for ( auto &worker : workers )
+      worker.join();
+  }
+
+  const auto startSelect = steady_t::now();
+  vector< hit_t > hits;
+  for ( auto &slice : threadHits )
+    hits.insert( hits.end(), slice.begin(), slice.end() );
+  const size_t resultSize = options.topK > 0 ? min( options.topK, hits.size() ) : hits.size();
+  partial_sort( hits.begin(), hits.begin() + static_cast< ptrdiff_t >( resultSize ), hits.end(), better );
+  hits.resize( resultSize );
+
+  const auto startPositions = steady_t::now();
+  vector< vector< u32 > > positions;
+  if ( options.positions )
+  {
+    positions.reserve( hits.size() );
+    for ( const auto &hit : hits )
+      positions.push_back(
+        fuzzy_score_n::fzs_get_match_positions( candidates[ hit.index ].text, options.pattern, contexts[ 0 ] ) );
+  }
+
+  const auto startWrite = steady_t::now();
+  {
+    output_c out;
+    for ( size_t h = 0; h < hits.size(); ++h )
+    {
+      const auto &candidate = candidates[ hits[ h ].index ];
+      if ( options.scores )
+      {
+        out.write_number( hits[ h ].score );
+        out.write( "\t" );
+      }
+      out.write( string_view( candidate.text, candidate.size ) );
+      if ( options.positions )
+      {
+        out.write( "\t" );
+        for ( size_t p = 0; p < positions[ h ].size(); ++p )
+        {
+          if ( p > 0 )
+            out.write( "," );
+          out.write_number( positions[ h ][ p ] );
+        }
+      }
+      out.write( "\n" );
+    }
+  }
+  fflush( stdout );
+  const auto end = steady_t::now();
+
+  if ( options.bench )
+  {
+    const double scoreMs = ms( startScore, startSelect ) / options.rounds;
+    fprintf( stderr,
+             "candidates: %u  results: %zu  threads: %u  rounds: %u\n"
+             "read:      %10.3f ms\n"
+             "score:     %10.3f ms/round (%.1f M candidates/s)\n"
+             "select:    %10.3f ms\n"
+             "positions: %10.3f ms\n"
+             "write:     %10.3f ms\n"
+             "total:     %10.3f ms\n",
+             candidateCount,
+             hits.size(),
+             threadCount,
+             options.rounds,
+             ms( startRead, startScore ),
+             scoreMs,
+             scoreMs > 0 ? candidateCount / scoreMs / 1000.0 : 0.0,
+             ms( startSelect, startPositions ),
+             ms( startPositions, startWrite ),
+             ms( startWrite, end ),
+             ms( startRead, end ) );
+  }
+
+  return hits.empty() ? 1 : 0;
+}
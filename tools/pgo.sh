@@ -0,0 +1,107 @@
+#!/bin/sh
+# Helper for the profile guided build (make pgo / cmake preset release-pgo).
+#
+#   pgo.sh corpus FILE                      generate the path corpus used for training
+#   pgo.sh train FZS_FILTER CORPUS          run the training workload with an instrumented fzs-filter
+#   pgo.sh merge LLVM_PROFDATA PROFILE_DIR  clang only: merge *.profraw into PROFILE_DIR/fzs.profdata
+#   pgo.sh report PLAIN PGO CORPUS          compare the scoring time of a plain and a pgo fzs-filter
+set -e
+
+# representative prompts: single chars, whole words, fuzzy gaps, multi token, strict (upper case/utf-8)
+PATTERNS='m
+i
+init
+read
+config
+mpns
+rndr
+wrapper unsafe
+loc util cpp
+engine math h
+que ue
+map sug ope
+Mail
+INT cmake
+über text
+src/net'
+
+corpus() {
+  # deterministic (fixed seed), ~250k paths similar to a large source tree
+  awk 'BEGIN {
+    srand(42)
+    nd = split("src include lib core network engine util test tests lua third_party dom gfx layout js " \
+               "netwerk toolkit widget xpcom docshell media build tools docs python rust ipc security " \
+               "mozglue accessible browser components modules internal detail impl platform linux win mac", d, " ")
+    nw = split("wrapper unsafe location util queue mail config parser thread pool render renderer math string " \
+               "helpers init event system station header suggest mapping integration resource loader memory " \
+               "manager database connector file utils logger error handler network unique type range cache " \
+               "index search token buffer stream socket frame layer shader texture font glyph style sheet", w, " ")
+    ne = split(".cpp .cpp .cpp .h .h .h .c .cc .hpp .lua .py .rs .js .md .txt .cmake .json .toml .xml", e, " ")
+    nu = split("README.md CMakeLists.txt Makefile LICENSE INTEGRATION.cmake Übersicht.md übertrieben.xml " \
+               "MailQueue.h WrapperUnsafe.cpp moz.build", u, " ")
+    for (n = 0; n < 250000; ++n) {
+      path = ""
+      depth = 1 + int(rand() * 6)
+      for (i = 0; i < depth; ++i)
+        path = path d[1 + int(rand() * nd)] "/"
+      if (rand() < 0.03) {
+        print path u[1 + int(rand() * nu)]
+        continue
+      }
+      name = w[1 + int(rand() * nw)]
+      parts = int(rand() * 3)
+      for (i = 0; i < parts; ++i)
+        name = name (rand() < 0.8 ? "_" : "-") w[1 + int(rand() * nw)]
+      if (rand() < 0.1)
+        name = toupper(substr(name, 1, 1)) substr(name, 2)
+      print path name e[1 + int(rand() * ne)]
+    }
+  }' > "$1"
+}
+
+train() {
+  filter=$1
+  corpus=$2
+  echo "$PATTERNS" | while IFS= read -r pattern; do
+    "$filter" -j 1 -r 3 "$pattern" "$corpus" > /dev/null || true
+    "$filter" -k 50 -p "$pattern" "$corpus" > /dev/null || true
+  done
+}
+
+merge() {
+  "$1" merge -o "$2/fzs.profdata" "$2"/*.profraw
+}
+
+# average scoring time of one pattern in ms (single thread)
+score_ms() {
+  "$1" -b -j 1 -r 10 "$2" "$3" 2>&1 > /dev/null | awk '/^score:/ { print $2 }'
+}
+
+report() {
+  plain=$1
+  pgo=$2
+  corpus=$3
+  printf '%-16s %12s %12s %8s\n' pattern 'plain ms' 'pgo ms' speedup
+  echo "$PATTERNS" | {
+    plainSum=0
+    pgoSum=0
+    while IFS= read -r pattern; do
+      plainMs=$(score_ms "$plain" "$pattern" "$corpus")
+      pgoMs=$(score_ms "$pgo" "$pattern" "$corpus")
+      printf '%-16s %12.3f %12.3f %7.2fx\n' "$pattern" "$plainMs" "$pgoMs" "$(echo "$plainMs $pgoMs" | awk '{ print $1 / $2 }')"
+      plainSum=$(echo "$plainSum $plainMs" | awk '{ print $1 + $2 }')
+      pgoSum=$(echo "$pgoSum $pgoMs" | awk '{ print $1 + $2 }')
+    done
+    printf '%-16s %12.3f %12.3f %7.2fx\n' total "$plainSum" "$pgoSum" "$(echo "$plainSum $pgoSum" | awk '{ print $1 / $2 }')"
+  }
+}
+
+command=$1
+shift
+case "$command" in
+  corpus | train | merge | report) "$command" "$@" ;;
+  *)
+    echo "usage: pgo.sh corpus|train|merge|report ..." >&2
+    exit 2
+    ;;
+esac